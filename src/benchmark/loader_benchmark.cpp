@@ -0,0 +1,82 @@
+// Measures heap allocations per load for a pooled Loader versus a fresh one per load.
+// Usage: loader_benchmark <file.gltf|file.glb> [iterations]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "../loader.h"
+
+using namespace GLTF;
+
+static std::atomic<size_t> g_allocations(0);
+
+void* operator new(size_t size) {
+    g_allocations++;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+struct Result {
+    double allocationsPerLoad;
+    double millisecondsPerLoad;
+};
+
+template <typename Fn>
+Result measure(int iterations, Fn load) {
+    // Silence the loader's progress output while timing
+    std::streambuf* out = std::cout.rdbuf(nullptr);
+
+    load(); // Warm up
+    size_t before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        load();
+    }
+    auto end = std::chrono::steady_clock::now();
+    size_t allocations = g_allocations - before;
+
+    std::cout.rdbuf(out);
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    return { (double)allocations / iterations, elapsed.count() / iterations };
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <file.gltf|file.glb> [iterations]" << std::endl;
+        return 1;
+    }
+    std::string filename(argv[1]);
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    std::vector<int> indices;
+    std::vector<Vector3> positions;
+
+    Result fresh = measure(iterations, [&]() {
+        Loader loader;
+        loader.loadGltf(filename, indices, positions);
+    });
+
+    Loader pooled;
+    Result steady = measure(iterations, [&]() {
+        pooled.loadGltf(filename, indices, positions);
+    });
+
+    std::cout << "Fresh loader:  " << fresh.allocationsPerLoad << " allocations/load, "
+              << fresh.millisecondsPerLoad << " ms/load" << std::endl;
+    std::cout << "Pooled loader: " << steady.allocationsPerLoad << " allocations/load, "
+              << steady.millisecondsPerLoad << " ms/load" << std::endl;
+    std::cout << "Retained: " << pooled.retainedBytes() << " bytes" << std::endl;
+    return 0;
+}
@@ -1,4 +1,7 @@
 #include "gltf.h"
+#include "loader.h"
+
+#include <cctype>
 
 bool GLTF::getOpenFilename(std::string& filename) {
 #ifdef _WIN32 // Boilerplate windows code
@@ -34,6 +37,9 @@ void GLTF::openBinaryFile(const std::string& filename, std::vector<char>& buffer
     /// Open file
     std::cout << "Opening file " << filename << "..." << std::endl;
     std::ifstream file(filename, std::ios::binary);    // Read as binary file
+    if (!file) {
+        throw FileReadError("Unable to open file " + filename);
+    }
 
     // Get file size
     file.seekg(0, std::ios::end);                // Move to end
@@ -49,6 +55,23 @@ void GLTF::openBinaryFile(const std::string& filename, std::vector<char>& buffer
     file.close();
 }
 
+std::string GLTF::decodeUri(const std::string& uri) {
+    std::string path;
+    path.reserve(uri.size());
+    for (size_t i = 0; i < uri.size(); i++) {
+        // %XX is a percent-encoded byte; anything malformed is kept as written
+        if (uri[i] == '%' && i + 2 < uri.size()
+            && std::isxdigit(static_cast<unsigned char>(uri[i + 1]))
+            && std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+            path.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            path.push_back(uri[i]);
+        }
+    }
+    return path;
+}
+
 bool GLTF::parseBinary(std::vector<char>& buffer) {
     for (int i = 0; i < buffer.size(); i++) {
         std::cout << buffer[i] << std::endl;
@@ -56,18 +79,23 @@ bool GLTF::parseBinary(std::vector<char>& buffer) {
     return false;
 }
 
-bool GLTF::loadGltf(std::vector<int>& indices, std::vector<Vector3>& positions) {
-    // Initial variables
-    JSON::JsonObject json;
-    std::vector<char> buffer;
-    size_t size;
+void GLTF::loadAsset(const std::string& filename, Asset& asset) {
+    // Forget the previous file before anything can throw, so a failed load never leaves
+    // the old tree or BIN range describing the new buffer. Dropping the old tree first
+    // also means it is never alive at the same time as the new one.
+    asset.json.reset();
+    asset.buffer.clear();
+    asset.binOffset = 0;
+    asset.binSize = 0;
+    asset.uriData.clear();
+    asset.filename = filename;
 
-    // Get the file to load
-    std::string filename;
-    if (!getOpenFilename(filename)) {
-        std::cout << "No file selected." << std::endl;
-        return false;
-    }
+    // The parsed tree is only published to the asset once the whole file has loaded
+    std::unique_ptr<JSON::JsonObject> tree;
+
+    // Relative URIs (companion .bin, external images) resolve against this directory
+    size_t separator = filename.find_last_of("/\\");
+    asset.directory.assign(filename, 0, separator == std::string::npos ? 0 : separator + 1);
 
     // Extract file type
     std::string filetype = filename.substr(filename.find_last_of(".") + 1);
@@ -76,17 +104,25 @@ bool GLTF::loadGltf(std::vector<int>& indices, std::vector<Vector3>& positions)
     // Read JSON and BIN components into memory
     if (filetype == "gltf") {
         // .gltf is a JSON file itself, with a companion .bin file for the geometry.
-        // We can load the .gltf file itself as a JSON object
-        json = JSON::loadFile(filename);
+        // We can load the .gltf file itself as a JSON object. It's read through our own
+        // buffer so the memory for the JSON text is reused between loads.
+        openBinaryFile(filename, asset.buffer);
+        asset.jsonText.assign(asset.buffer.begin(), asset.buffer.end());
+        tree.reset(new JSON::JsonObject(JSON::loadString(asset.jsonText)));
+        JSON::JsonObject& json = *tree;
+        asset.buffer.clear();
 
         // We'll need to get the companion .bin file, which is in the 'buffers' element
-        std::string filepath = filename.substr(0, filename.find_last_of('\\'));
-        std::string binFilename;
-        binFilename = filepath + "\\" + (std::string)json["buffers"][0]["uri"];
-        std::cout << "Companion .bin file: " << binFilename << std::endl;
-
-        // Load the .bin file into our memory buffer
-        openBinaryFile(binFilename, buffer);
+        // Embedded data: URIs are decoded lazily by getBufferData instead.
+        if (json.hasKey("buffers") && json["buffers"].size() > 0 && json["buffers"][0].hasKey("uri")
+            && ((std::string)json["buffers"][0]["uri"]).rfind("data:", 0) != 0) {
+            std::string binFilename = asset.directory + decodeUri((std::string)json["buffers"][0]["uri"]);
+            std::cout << "Companion .bin file: " << binFilename << std::endl;
+
+            // Load the .bin file into our memory buffer
+            openBinaryFile(binFilename, asset.buffer);
+            asset.binSize = asset.buffer.size();
+        }
     } else if (filetype == "glb") {
         // Otherwise we've loaded a .glb which has three components:
         // 1. The 12-byte header
@@ -95,8 +131,12 @@ bool GLTF::loadGltf(std::vector<int>& indices, std::vector<Vector3>& positions)
         std::cout << ".glb loaded, no companion .bin file needed." << std::endl;
 
         // Load the .glb file into our memory buffer
+        std::vector<char>& buffer = asset.buffer;
         openBinaryFile(filename, buffer);
-        size = buffer.size();
+        size_t size = buffer.size();
+        if (size < 20) {
+            throw FileReadError("File too small to be a .glb: " + std::to_string(size) + " bytes");
+        }
 
         // Read the header
         auto ptr = reinterpret_cast<unsigned int*>(&buffer.at(0));
@@ -134,55 +174,50 @@ bool GLTF::loadGltf(std::vector<int>& indices, std::vector<Vector3>& positions)
         ptr++;
         size_t jsonSize = *ptr;
         std::cout << "JSON is " << jsonSize << " bytes" << std::endl;
+        if (20 + jsonSize > size) {
+            throw FileReadError("JSON chunk runs past the end of the file");
+        }
 
         // Extract JSON content as a string
         auto chunk = reinterpret_cast<const char *>(&buffer.at(20));
-        std::string jsonString(chunk, jsonSize);
-        json = JSON::loadString(jsonString);
-
-        // Extract the rest of the binary data
-        auto dataOffset = 20 + jsonSize;
-        auto dataSize = fileSize - dataOffset;
-        std::vector<char> temp(buffer.begin() + dataOffset, buffer.end());
-        buffer = temp;
-        
+        asset.jsonText.assign(chunk, jsonSize);
+        tree.reset(new JSON::JsonObject(JSON::loadString(asset.jsonText)));
+
+        // The optional BIN chunk follows with its own 8-byte header (length, 'BIN\0').
+        // Rather than copying it out, we keep the whole file and address it in place.
+        size_t chunkOffset = 20 + jsonSize;
+        if (chunkOffset + 8 <= size) {
+            auto chunkHeader = reinterpret_cast<const unsigned int*>(&buffer.at(chunkOffset));
+            size_t chunkSize = chunkHeader[0];
+            if (std::string(reinterpret_cast<const char*>(&chunkHeader[1]), 4) != std::string("BIN\0", 4)) {
+                throw FileReadError("Expected BIN chunk after JSON chunk");
+            }
+            if (chunkOffset + 8 + chunkSize > size) {
+                throw FileReadError("BIN chunk runs past the end of the file");
+            }
+            asset.binOffset = chunkOffset + 8;
+            asset.binSize = chunkSize;
+        }
     } else {
         // If we've somehow gotten here, we've got the wrong filetype
         std::string msg("Unable to read file of type " + filetype);
         throw FileReadError(msg);
     }
 
-    std::cout << json.format() << std::endl;
-
-    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.pdf
-
-    auto meshes = json["meshes"];
-    for (int i = 0; i < meshes.size(); i++) {
-        auto mesh = json["meshes"][i];
-        auto primitives = mesh["primitives"];
-        for (int j = 0; j < primitives.size(); j++) {
-            auto primitive = mesh["primitives"][j];
-
-            // Extract buffer entities
-            std::map<std::string, int> entities;
-            for (auto& [k, v] : (JSON::JsonDict) primitive["attributes"]) {
-                entities[k] = (int) v;
-            }
-            if (primitive.hasKey("indices")) {
-                entities["indices"] = (int) primitive["indices"];
-            }
-            if (primitive.hasKey("material")) {
-                entities["material"] = (int) primitive["material"];
-            }
-            if (primitive.hasKey("mode")) {
-                entities["mode"] = (int) primitive["mode"];
-            }
+    asset.json = std::move(tree);
+}
 
-            for (auto& [k, v] : entities) {
-                std::cout << k << ": " << std::to_string(v) << std::endl;
-            }
-        }
+bool GLTF::loadGltf(std::vector<int>& indices, std::vector<Vector3>& positions) {
+    // Get the file to load
+    std::string filename;
+    if (!getOpenFilename(filename)) {
+        std::cout << "No file selected." << std::endl;
+        return false;
     }
-    //bool result = parseBinary(buffer);
-    return true;
+
+    // One-shot load; long-running callers should keep a Loader around instead
+    Loader loader;
+    loader.load(filename);
+    std::cout << loader.asset().json->format() << std::endl;
+    return loader.readMeshes(indices, positions);
 }
\ No newline at end of file
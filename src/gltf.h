@@ -8,6 +8,8 @@
 #endif
 
 #include <exception>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include "json.h"
@@ -44,6 +46,21 @@ namespace GLTF {
         GL_FLOAT = 5126,
     };
 
+    enum SamplerFilters {
+        GL_NEAREST = 9728,
+        GL_LINEAR = 9729,
+        GL_NEAREST_MIPMAP_NEAREST = 9984,
+        GL_LINEAR_MIPMAP_NEAREST = 9985,
+        GL_NEAREST_MIPMAP_LINEAR = 9986,
+        GL_LINEAR_MIPMAP_LINEAR = 9987,
+    };
+
+    enum SamplerWrapModes {
+        GL_REPEAT = 10497,
+        GL_CLAMP_TO_EDGE = 33071,
+        GL_MIRRORED_REPEAT = 33648,
+    };
+
     enum AccessorComponentTypes {
         SCALAR
     };
@@ -58,9 +75,47 @@ namespace GLTF {
         int type;
     };
 
+    /// <summary>
+    /// Non-owning view over a range of bytes. Only valid while the Asset it
+    /// was taken from is alive.
+    /// </summary>
+    struct ByteSpan {
+        const char* data = nullptr;
+        size_t size = 0;
+
+        bool empty() const {
+            return size == 0;
+        }
+    };
+
+    /// <summary>
+    /// A loaded .gltf or .glb file. `buffer` holds the whole .glb (or the
+    /// companion .bin for .gltf) and the BIN chunk is addressed in place.
+    /// </summary>
+    struct Asset {
+        std::string filename;
+        std::string directory;
+        // JsonObject has no move operations, so the tree is held by pointer and
+        // constructed in place rather than deep-copied into an existing object
+        std::unique_ptr<JSON::JsonObject> json;
+        std::string jsonText;
+        std::vector<char> buffer;
+        size_t binOffset = 0;
+        size_t binSize = 0;
+
+        // External and data: URIs, loaded on first request and keyed by URI
+        std::map<std::string, std::vector<char>> uriData;
+
+        ByteSpan bin() const {
+            return { buffer.data() + binOffset, binSize };
+        }
+    };
+
     bool getOpenFilename(std::string& filename);
     void openBinaryFile(const std::string& filename, std::vector<char>& buffer);
+    std::string decodeUri(const std::string& uri);
     bool parseBinary(std::vector<char>& buffer);
+    void loadAsset(const std::string& filename, Asset& asset);
     bool loadGltf(std::vector<int>& indices, std::vector<Vector3>& positions);
 }
 
@@ -0,0 +1,190 @@
+#include "images.h"
+
+namespace {
+    int base64Value(char c) {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+    }
+
+    void decodeBase64(const std::string& input, size_t offset, std::vector<char>& output) {
+        output.clear();
+        output.reserve((input.size() - offset) / 4 * 3);
+
+        unsigned int bits = 0;
+        int bitCount = 0;
+        for (size_t i = offset; i < input.size() && input[i] != '='; i++) {
+            int value = base64Value(input[i]);
+            if (value < 0) {
+                throw GLTF::FileReadError("Invalid base64 character in data URI");
+            }
+            bits = (bits << 6) | value;
+            bitCount += 6;
+            if (bitCount >= 8) {
+                bitCount -= 8;
+                output.push_back(static_cast<char>((bits >> bitCount) & 0xFF));
+            }
+        }
+    }
+
+    // Loads a URI into the asset's cache on first use. References into a std::map
+    // stay valid as other entries are added, so returned spans don't move.
+    GLTF::ByteSpan resolveUri(GLTF::Asset& asset, const std::string& uri) {
+        auto it = asset.uriData.find(uri);
+        if (it == asset.uriData.end()) {
+            std::vector<char> data;
+            if (uri.rfind("data:", 0) == 0) {
+                // data:[<mediatype>];base64,<data>
+                size_t comma = uri.find(',');
+                if (comma == std::string::npos || uri.rfind(";base64", comma) == std::string::npos) {
+                    throw GLTF::FileReadError("Unsupported data URI");
+                }
+                decodeBase64(uri, comma + 1, data);
+            } else {
+                GLTF::openBinaryFile(asset.directory + GLTF::decodeUri(uri), data);
+            }
+            it = asset.uriData.emplace(uri, std::move(data)).first;
+        }
+        return { it->second.data(), it->second.size() };
+    }
+
+    // The tree is empty on a default Asset and after Loader::release()
+    void checkLoaded(const GLTF::Asset& asset) {
+        if (!asset.json) {
+            throw GLTF::FileReadError("No asset loaded");
+        }
+    }
+
+    std::string getName(JSON::JsonObject& object) {
+        return object.hasKey("name") ? (std::string)object["name"] : std::string();
+    }
+}
+
+std::vector<GLTF::Image> GLTF::getImages(Asset& asset) {
+    std::vector<Image> images;
+    if (!asset.json || !asset.json->hasKey("images")) {
+        return images;
+    }
+
+    auto& array = (*asset.json)["images"];
+    for (int i = 0; i < static_cast<int>(array.size()); i++) {
+        auto& object = array[i];
+        Image image;
+        image.name = getName(object);
+        if (object.hasKey("uri")) {
+            image.uri = (std::string)object["uri"];
+        }
+        if (object.hasKey("mimeType")) {
+            image.mimeType = (std::string)object["mimeType"];
+        }
+        if (object.hasKey("bufferView")) {
+            image.bufferView = (int)object["bufferView"];
+        }
+        images.push_back(image);
+    }
+    return images;
+}
+
+std::vector<GLTF::Sampler> GLTF::getSamplers(Asset& asset) {
+    std::vector<Sampler> samplers;
+    if (!asset.json || !asset.json->hasKey("samplers")) {
+        return samplers;
+    }
+
+    auto& array = (*asset.json)["samplers"];
+    for (int i = 0; i < static_cast<int>(array.size()); i++) {
+        auto& object = array[i];
+        Sampler sampler;
+        sampler.name = getName(object);
+        if (object.hasKey("magFilter")) {
+            sampler.magFilter = (int)object["magFilter"];
+        }
+        if (object.hasKey("minFilter")) {
+            sampler.minFilter = (int)object["minFilter"];
+        }
+        if (object.hasKey("wrapS")) {
+            sampler.wrapS = (int)object["wrapS"];
+        }
+        if (object.hasKey("wrapT")) {
+            sampler.wrapT = (int)object["wrapT"];
+        }
+        samplers.push_back(sampler);
+    }
+    return samplers;
+}
+
+std::vector<GLTF::Texture> GLTF::getTextures(Asset& asset) {
+    std::vector<Texture> textures;
+    if (!asset.json || !asset.json->hasKey("textures")) {
+        return textures;
+    }
+
+    auto& array = (*asset.json)["textures"];
+    for (int i = 0; i < static_cast<int>(array.size()); i++) {
+        auto& object = array[i];
+        Texture texture;
+        texture.name = getName(object);
+        if (object.hasKey("sampler")) {
+            texture.sampler = (int)object["sampler"];
+        }
+        if (object.hasKey("source")) {
+            texture.source = (int)object["source"];
+        }
+        textures.push_back(texture);
+    }
+    return textures;
+}
+
+GLTF::ByteSpan GLTF::getBufferData(Asset& asset, int buffer) {
+    checkLoaded(asset);
+    auto& buffers = (*asset.json)["buffers"];
+    if (buffer < 0 || buffer >= static_cast<int>(buffers.size())) {
+        throw FileReadError("Invalid buffer index " + std::to_string(buffer));
+    }
+
+    // The first buffer is the BIN chunk (.glb) or the companion .bin (.gltf), already in memory
+    if (buffer == 0 && asset.binSize > 0) {
+        return asset.bin();
+    }
+    if (!buffers[buffer].hasKey("uri")) {
+        throw FileReadError("Buffer " + std::to_string(buffer) + " has no data");
+    }
+    return resolveUri(asset, (std::string)buffers[buffer]["uri"]);
+}
+
+GLTF::ByteSpan GLTF::getBufferViewData(Asset& asset, int bufferView) {
+    checkLoaded(asset);
+    auto& bufferViews = (*asset.json)["bufferViews"];
+    if (bufferView < 0 || bufferView >= static_cast<int>(bufferViews.size())) {
+        throw FileReadError("Invalid bufferView index " + std::to_string(bufferView));
+    }
+
+    auto& view = bufferViews[bufferView];
+    ByteSpan buffer = getBufferData(asset, (int)view["buffer"]);
+    int byteOffset = view.hasKey("byteOffset") ? (int)view["byteOffset"] : 0;
+    int byteLength = (int)view["byteLength"];
+    if (byteOffset < 0 || byteLength < 0) {
+        throw FileReadError("bufferView " + std::to_string(bufferView) + " has a negative offset or length");
+    }
+
+    // Written so neither side can overflow; the span must never leave its buffer
+    size_t offset = static_cast<size_t>(byteOffset);
+    size_t length = static_cast<size_t>(byteLength);
+    if (offset > buffer.size || length > buffer.size - offset) {
+        throw FileReadError("bufferView " + std::to_string(bufferView) + " runs past the end of its buffer");
+    }
+    return { buffer.data + offset, length };
+}
+
+GLTF::ByteSpan GLTF::getImageData(Asset& asset, const Image& image) {
+    if (image.bufferView >= 0) {
+        return getBufferViewData(asset, image.bufferView);
+    }
+    if (!image.uri.empty()) {
+        return resolveUri(asset, image.uri);
+    }
+    throw FileReadError("Image '" + image.name + "' has neither a bufferView nor a uri");
+}
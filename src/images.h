@@ -0,0 +1,55 @@
+#ifndef IMAGES_H
+#define IMAGES_H
+
+#include <string>
+#include <vector>
+#include "gltf.h"
+
+namespace GLTF {
+
+    struct Image {
+        std::string name;
+        std::string uri;        // Empty when the image is embedded via bufferView
+        std::string mimeType;   // Required by the spec when bufferView is set
+        int bufferView = -1;
+    };
+
+    struct Sampler {
+        std::string name;
+        int magFilter = -1;     // -1 when unset; the renderer picks
+        int minFilter = -1;
+        int wrapS = GL_REPEAT;
+        int wrapT = GL_REPEAT;
+    };
+
+    struct Texture {
+        std::string name;
+        int sampler = -1;
+        int source = -1;        // Index into the images array
+    };
+
+    std::vector<Image> getImages(Asset& asset);
+    std::vector<Sampler> getSamplers(Asset& asset);
+    std::vector<Texture> getTextures(Asset& asset);
+
+    /// <summary>
+    /// Returns the bytes of the given buffer. The BIN chunk (or the companion .bin
+    /// of a .gltf) is returned in place; external and data: URIs are loaded on
+    /// first use and cached on the asset.
+    /// </summary>
+    ByteSpan getBufferData(Asset& asset, int buffer);
+
+    /// <summary>
+    /// Returns the bytes the given bufferView covers, without copying.
+    /// </summary>
+    ByteSpan getBufferViewData(Asset& asset, int bufferView);
+
+    /// <summary>
+    /// Returns the encoded (PNG, JPEG, KTX2, ...) bytes of the given image. Images
+    /// embedded through a bufferView point straight into the loaded buffer; images
+    /// with a URI are resolved lazily, the first time they are requested.
+    /// </summary>
+    ByteSpan getImageData(Asset& asset, const Image& image);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include "loader.h"
+
+#include <algorithm>
+
+GLTF::Asset& GLTF::Loader::load(const std::string& filename) {
+    // Trim before loading rather than after, so the returned asset's buffers stay valid
+    trim();
+    loadAsset(filename, m_asset);
+    return m_asset;
+}
+
+bool GLTF::Loader::loadGltf(const std::string& filename, std::vector<int>& indices, std::vector<Vector3>& positions) {
+    load(filename);
+    return readMeshes(indices, positions);
+}
+
+bool GLTF::Loader::readMeshes(std::vector<int>& indices, std::vector<Vector3>& positions) {
+    indices.clear();
+    positions.clear();
+    if (!m_asset.json) {
+        return false; // Nothing loaded, or released since
+    }
+
+    // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.pdf
+
+    // Walk the tree by reference; copying a JsonObject deep-copies its whole subtree
+    JSON::JsonObject& json = *m_asset.json;
+    if (!json.hasKey("meshes")) {
+        return true;
+    }
+    auto& meshes = json["meshes"];
+    for (int i = 0; i < static_cast<int>(meshes.size()); i++) {
+        auto& primitives = meshes[i]["primitives"];
+        for (int j = 0; j < static_cast<int>(primitives.size()); j++) {
+            auto& primitive = primitives[j];
+
+            // Extract buffer entities, overwriting last primitive's entries in place
+            size_t count = 0;
+            auto setEntity = [&](const std::string& name, int value) {
+                if (count < m_entities.size()) {
+                    m_entities[count].first = name;
+                    m_entities[count].second = value;
+                } else {
+                    m_entities.emplace_back(name, value);
+                }
+                count++;
+            };
+            for (auto& [k, v] : *primitive["attributes"].asDict().ptr()) {
+                setEntity(k, (int) v);
+            }
+            if (primitive.hasKey("indices")) {
+                setEntity("indices", (int) primitive["indices"]);
+            }
+            if (primitive.hasKey("material")) {
+                setEntity("material", (int) primitive["material"]);
+            }
+            if (primitive.hasKey("mode")) {
+                setEntity("mode", (int) primitive["mode"]);
+            }
+            std::sort(m_entities.begin(), m_entities.begin() + count);
+
+            for (size_t e = 0; e < count; e++) {
+                std::cout << m_entities[e].first << ": " << m_entities[e].second << std::endl;
+            }
+        }
+    }
+    return true;
+}
+
+size_t GLTF::Loader::retainedBytes() const {
+    size_t bytes = m_asset.buffer.capacity() + m_asset.jsonText.capacity();
+    bytes += m_entities.capacity() * sizeof(m_entities[0]);
+    for (auto& [uri, data] : m_asset.uriData) {
+        bytes += data.capacity();
+    }
+    return bytes;
+}
+
+void GLTF::Loader::setHighWaterMark(size_t bytes) {
+    m_highWaterMark = bytes;
+}
+
+void GLTF::Loader::trim() {
+    if (retainedBytes() > m_highWaterMark) {
+        release();
+    }
+}
+
+void GLTF::Loader::release() {
+    // Swapping with empties is the only portable way to actually give the memory back
+    std::vector<char>().swap(m_asset.buffer);
+    std::string().swap(m_asset.jsonText);
+    std::string().swap(m_asset.filename);
+    std::string().swap(m_asset.directory);
+    m_asset.json.reset();
+    std::vector<std::pair<std::string, int>>().swap(m_entities);
+    m_asset.uriData.clear();
+    m_asset.binOffset = 0;
+    m_asset.binSize = 0;
+}
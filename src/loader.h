@@ -0,0 +1,83 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gltf.h"
+
+namespace GLTF {
+
+    // Default amount of scratch memory a Loader keeps between loads
+    constexpr size_t DEFAULT_HIGH_WATER_MARK = 64 * 1024 * 1024;
+
+    /// <summary>
+    /// Reusable loading context. Buffers are reset rather than freed between loads,
+    /// so a Loader kept alive by a long-running service stops allocating once it
+    /// has seen its largest file. If the memory retained from the previous load
+    /// exceeds the high-water mark, it is released when the next load starts.
+    /// </summary>
+    class Loader {
+        Asset m_asset;
+
+        // Per-primitive attribute/accessor pairs, reused for every primitive
+        std::vector<std::pair<std::string, int>> m_entities;
+
+        size_t m_highWaterMark;
+
+        /// <summary>
+        /// Releases the retained scratch memory if it has grown past the high-water mark.
+        /// Only called between loads, since it invalidates the current Asset.
+        /// </summary>
+        void trim();
+
+    public:
+        explicit Loader(size_t highWaterMark = DEFAULT_HIGH_WATER_MARK)
+            : m_highWaterMark(highWaterMark) {
+        };
+
+        /// <summary>
+        /// Loads the given .gltf or .glb into the pooled Asset. The returned reference,
+        /// and any ByteSpan taken from it, is valid until the next call to load.
+        /// </summary>
+        Asset& load(const std::string& filename);
+
+        /// <summary>
+        /// Walks the meshes of the loaded asset and fills `indices` and `positions`. Both
+        /// are cleared first, keeping their capacity so callers can reuse them too.
+        /// </summary>
+        bool readMeshes(std::vector<int>& indices, std::vector<Vector3>& positions);
+
+        /// <summary>
+        /// Equivalent to load() followed by readMeshes().
+        /// </summary>
+        bool loadGltf(const std::string& filename, std::vector<int>& indices, std::vector<Vector3>& positions);
+
+        Asset& asset() {
+            return m_asset;
+        }
+
+        /// <summary>
+        /// Bytes of raw scratch memory currently held for reuse: the file buffer, JSON text,
+        /// entity list and cached URI data. The parsed JSON tree's size can't be measured
+        /// from outside the JSON library, so it is not counted against the high-water mark;
+        /// it is freed by release() all the same.
+        /// </summary>
+        size_t retainedBytes() const;
+
+        size_t highWaterMark() const {
+            return m_highWaterMark;
+        }
+
+        void setHighWaterMark(size_t bytes);
+
+        /// <summary>
+        /// Frees all retained memory immediately, including the parsed JSON tree.
+        /// Invalidates the current Asset and any spans into it.
+        /// </summary>
+        void release();
+    };
+}
+
+#endif
@@ -0,0 +1,347 @@
+#include "optimize.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    // Forsyth's scoring constants
+    // https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    // FNV-1a over the raw vertex bytes
+    uint64_t hashVertex(const char* vertex, size_t stride) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < stride; i++) {
+            hash ^= static_cast<unsigned char>(vertex[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    float vertexScore(int cachePosition, int remaining) {
+        if (remaining == 0) {
+            return -1.0f; // No triangles left to emit, so never worth picking
+        }
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // Used by the last triangle; fixed score so it isn't favoured over its neighbours
+                score = LAST_TRIANGLE_SCORE;
+            } else {
+                float scale = 1.0f / (GLTF::VERTEX_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+            }
+        }
+
+        // Boost vertices with few triangles left so we don't leave lone triangles behind
+        score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining), -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    void checkIndices(const std::vector<int>& indices, size_t vertexCount) {
+        for (int index : indices) {
+            if (index < 0 || static_cast<size_t>(index) >= vertexCount) {
+                throw std::out_of_range("Index " + std::to_string(index) + " out of range of "
+                                        + std::to_string(vertexCount) + " vertices");
+            }
+        }
+    }
+
+    // Non-indexed primitives get an identity index buffer so welding has something to remap;
+    // otherwise the duplicates would be compacted away with nothing referencing the survivors.
+    void prepareIndices(std::vector<int>& indices, size_t vertexCount) {
+        if (indices.empty()) {
+            indices.resize(vertexCount);
+            std::iota(indices.begin(), indices.end(), 0);
+        } else {
+            checkIndices(indices, vertexCount);
+        }
+    }
+}
+
+size_t GLTF::weldVertices(std::vector<int>& indices, char* vertices, size_t stride, size_t vertexCount) {
+    if (vertexCount == 0 || stride == 0) {
+        return 0;
+    }
+    checkIndices(indices, vertexCount);
+
+    // Open-addressed table of unique vertex positions, sized to a power of two
+    size_t tableSize = 1;
+    while (tableSize < vertexCount + vertexCount / 2) {
+        tableSize <<= 1;
+    }
+    std::vector<int> table(tableSize, -1);
+    std::vector<int> remap(vertexCount);
+
+    size_t uniqueCount = 0;
+    for (size_t i = 0; i < vertexCount; i++) {
+        const char* vertex = vertices + i * stride;
+        size_t slot = hashVertex(vertex, stride) & (tableSize - 1);
+
+        // Linear probe until we find either a matching vertex or an empty slot
+        while (table[slot] != -1
+               && std::memcmp(vertices + table[slot] * stride, vertex, stride) != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if (table[slot] == -1) {
+            // First occurrence; compact it into the next unique slot. We only ever
+            // write behind `i`, so vertices still to be visited are untouched.
+            if (uniqueCount != i) {
+                std::memcpy(vertices + uniqueCount * stride, vertex, stride);
+            }
+            table[slot] = static_cast<int>(uniqueCount);
+            uniqueCount++;
+        }
+        remap[i] = table[slot];
+    }
+
+    for (int& index : indices) {
+        index = remap[index];
+    }
+    return uniqueCount;
+}
+
+void GLTF::optimizeVertexCache(std::vector<int>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || indices.size() % 3 != 0) {
+        return; // Only triangle lists can be reordered
+    }
+    checkIndices(indices, vertexCount);
+
+    // Build vertex -> triangle adjacency
+    std::vector<int> remaining(vertexCount, 0);
+    for (int index : indices) {
+        remaining[index]++;
+    }
+    std::vector<size_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<int> adjacency(indices.size());
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (size_t k = 0; k < 3; k++) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<int>(t);
+        }
+    }
+
+    // Initial scores
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        scores[v] = vertexScore(-1, remaining[v]);
+    }
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+    }
+
+    std::vector<int> output;
+    output.reserve(indices.size());
+
+    // Cache holds the most recent vertices, plus room for the three a triangle pushes in
+    std::vector<int> cache;
+    std::vector<int> newCache;
+    cache.reserve(VERTEX_CACHE_SIZE + 3);
+    newCache.reserve(VERTEX_CACHE_SIZE + 3);
+
+    int best = static_cast<int>(std::max_element(triangleScores.begin(), triangleScores.end())
+                                - triangleScores.begin());
+    size_t cursor = 0;
+
+    for (size_t count = 0; count < triangleCount; count++) {
+        if (best < 0) {
+            // Nothing adjacent to the cache is left; continue from the next unemitted triangle
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = static_cast<int>(cursor);
+        }
+
+        const int* triangle = &indices[best * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+        emitted[best] = true;
+
+        // Remove the triangle from each of its vertices' adjacency
+        for (size_t k = 0; k < 3; k++) {
+            int v = triangle[k];
+            int* begin = &adjacency[offsets[v]];
+            int* end = begin + remaining[v];
+            *std::find(begin, end, best) = *(end - 1);
+            remaining[v]--;
+        }
+
+        // Push the triangle's vertices to the front of the cache
+        newCache.assign(triangle, triangle + 3);
+        for (int v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                newCache.push_back(v);
+            }
+        }
+        std::swap(cache, newCache);
+
+        // Rescore everything in the cache; anything pushed past the end falls out
+        for (size_t i = 0; i < cache.size(); i++) {
+            int v = cache[i];
+            cachePosition[v] = i < VERTEX_CACHE_SIZE ? static_cast<int>(i) : -1;
+            float score = vertexScore(cachePosition[v], remaining[v]);
+            float delta = score - scores[v];
+            scores[v] = score;
+            for (size_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                triangleScores[adjacency[a]] += delta;
+            }
+        }
+        if (cache.size() > VERTEX_CACHE_SIZE) {
+            cache.resize(VERTEX_CACHE_SIZE);
+        }
+
+        // Pick the next triangle from those touching the cache
+        best = -1;
+        float bestScore = -1.0f;
+        for (int v : cache) {
+            for (size_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                int t = adjacency[a];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+size_t GLTF::optimizeVertexFetch(std::vector<int>& indices, char* vertices, size_t stride, size_t vertexCount) {
+    checkIndices(indices, vertexCount);
+
+    std::vector<int> remap(vertexCount, -1);
+    std::vector<char> scratch(vertexCount * stride);
+    size_t next = 0;
+    for (int& index : indices) {
+        if (remap[index] == -1) {
+            remap[index] = static_cast<int>(next);
+            std::memcpy(&scratch[next * stride], vertices + index * stride, stride);
+            next++;
+        }
+        index = remap[index];
+    }
+
+    if (next > 0) {
+        std::memcpy(vertices, scratch.data(), next * stride);
+    }
+    return next;
+}
+
+double GLTF::computeAcmr(const std::vector<int>& indices, size_t vertexCount, int cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return 0.0;
+    }
+    checkIndices(indices, vertexCount);
+
+    // A vertex is in the cache if fewer than `cacheSize` misses happened since it was loaded
+    std::vector<unsigned int> stamps(vertexCount, 0);
+    unsigned int timestamp = cacheSize + 1;
+    size_t misses = 0;
+    for (int index : indices) {
+        if (timestamp - stamps[index] > static_cast<unsigned int>(cacheSize)) {
+            stamps[index] = timestamp++;
+            misses++;
+        }
+    }
+    return static_cast<double>(misses) / triangleCount;
+}
+
+GLTF::OptimizeStats GLTF::optimizePrimitive(Primitive& primitive) {
+    OptimizeStats stats;
+    size_t vertexCount = primitive.vertexCount();
+    stats.vertexCountBefore = vertexCount;
+    stats.bytesBefore = primitive.vertices.size() + primitive.indices.size() * sizeof(int);
+    prepareIndices(primitive.indices, vertexCount);
+    stats.acmrBefore = computeAcmr(primitive.indices, vertexCount);
+
+    vertexCount = weldVertices(primitive.indices, primitive.vertices.data(), primitive.stride, vertexCount);
+    optimizeVertexCache(primitive.indices, vertexCount);
+    vertexCount = optimizeVertexFetch(primitive.indices, primitive.vertices.data(), primitive.stride, vertexCount);
+    primitive.vertices.resize(vertexCount * primitive.stride);
+
+    stats.vertexCountAfter = vertexCount;
+    stats.bytesAfter = primitive.vertices.size() + primitive.indices.size() * sizeof(int);
+    stats.acmrAfter = computeAcmr(primitive.indices, vertexCount);
+    return stats;
+}
+
+GLTF::OptimizeStats GLTF::optimizeMesh(std::vector<int>& indices, std::vector<Vector3>& positions) {
+    OptimizeStats stats;
+    size_t vertexCount = positions.size();
+    size_t stride = sizeof(Vector3);
+    stats.vertexCountBefore = vertexCount;
+    stats.bytesBefore = vertexCount * stride + indices.size() * sizeof(int);
+    prepareIndices(indices, vertexCount);
+    stats.acmrBefore = computeAcmr(indices, vertexCount);
+
+    // Vector3 is plain data, so the positions can be welded and reordered in place
+    auto data = reinterpret_cast<char*>(positions.data());
+    vertexCount = weldVertices(indices, data, stride, vertexCount);
+    optimizeVertexCache(indices, vertexCount);
+    vertexCount = optimizeVertexFetch(indices, data, stride, vertexCount);
+    positions.resize(vertexCount);
+
+    stats.vertexCountAfter = vertexCount;
+    stats.bytesAfter = vertexCount * stride + indices.size() * sizeof(int);
+    stats.acmrAfter = computeAcmr(indices, vertexCount);
+    return stats;
+}
+
+std::vector<GLTF::OptimizeStats> GLTF::optimizePrimitives(std::vector<Primitive>& primitives, unsigned int threadCount) {
+    std::vector<OptimizeStats> stats(primitives.size());
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, primitives.size()));
+
+    // Primitives are independent, so each worker just claims the next one
+    std::atomic<size_t> next(0);
+    std::vector<std::exception_ptr> errors(threadCount);
+    auto worker = [&](unsigned int id) {
+        try {
+            for (size_t i = next++; i < primitives.size(); i = next++) {
+                stats[i] = optimizePrimitive(primitives[i]);
+            }
+        } catch (...) {
+            errors[id] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker, i);
+    }
+    if (threadCount > 0) {
+        worker(0); // The calling thread does its share too
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return stats;
+}
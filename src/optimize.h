@@ -0,0 +1,96 @@
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include <cstddef>
+#include <vector>
+#include "gltf.h"
+
+namespace GLTF {
+
+    // Cache size the triangle reordering optimizes for
+    constexpr int VERTEX_CACHE_SIZE = 32;
+
+    // Cache size of the FIFO simulation used to report ACMR
+    constexpr int ACMR_CACHE_SIZE = 16;
+
+    /// <summary>
+    /// Results of running the post-process stage over a single primitive.
+    /// ACMR is the average cache miss ratio: transformed vertices per triangle.
+    /// </summary>
+    struct OptimizeStats {
+        size_t vertexCountBefore = 0;
+        size_t vertexCountAfter = 0;
+        size_t bytesBefore = 0;
+        size_t bytesAfter = 0;
+        double acmrBefore = 0.0;
+        double acmrAfter = 0.0;
+
+        size_t bytesSaved() const {
+            // Indexing a non-indexed primitive can cost more than welding saves
+            return bytesBefore > bytesAfter ? bytesBefore - bytesAfter : 0;
+        }
+    };
+
+    /// <summary>
+    /// A triangle list primitive with all of its attributes interleaved into
+    /// a single vertex buffer of `stride` bytes per vertex.
+    /// </summary>
+    struct Primitive {
+        std::vector<int> indices;
+        std::vector<char> vertices;
+        size_t stride = 0;
+
+        size_t vertexCount() const {
+            return stride == 0 ? 0 : vertices.size() / stride;
+        }
+    };
+
+    /// <summary>
+    /// Merges vertices whose interleaved bytes are identical and remaps the index
+    /// buffer. Unique vertices are compacted to the front of `vertices` in order of
+    /// first occurrence.
+    /// </summary>
+    /// <returns>The number of unique vertices.</returns>
+    size_t weldVertices(std::vector<int>& indices, char* vertices, size_t stride, size_t vertexCount);
+
+    /// <summary>
+    /// Reorders triangles for post-transform vertex cache locality using Forsyth's
+    /// linear-speed vertex cache optimization.
+    /// </summary>
+    void optimizeVertexCache(std::vector<int>& indices, size_t vertexCount);
+
+    /// <summary>
+    /// Reorders vertices into the order the index buffer first references them so
+    /// vertex fetches walk memory linearly. Unreferenced vertices are dropped.
+    /// </summary>
+    /// <returns>The number of referenced vertices.</returns>
+    size_t optimizeVertexFetch(std::vector<int>& indices, char* vertices, size_t stride, size_t vertexCount);
+
+    /// <summary>
+    /// Simulates a FIFO vertex cache of `cacheSize` entries over the index buffer.
+    /// Throws std::out_of_range if an index does not reference a vertex.
+    /// </summary>
+    /// <returns>The average number of cache misses per triangle.</returns>
+    double computeAcmr(const std::vector<int>& indices, size_t vertexCount, int cacheSize = ACMR_CACHE_SIZE);
+
+    /// <summary>
+    /// Runs the post-process stage over a single primitive in place: weld, then
+    /// vertex cache and vertex fetch reordering. An empty index buffer is treated
+    /// as a non-indexed primitive and replaced by a generated one.
+    /// </summary>
+    OptimizeStats optimizePrimitive(Primitive& primitive);
+
+    /// <summary>
+    /// Runs the post-process stage over an indices/positions pair. An empty index
+    /// buffer is treated as a non-indexed primitive and replaced by a generated one.
+    /// </summary>
+    OptimizeStats optimizeMesh(std::vector<int>& indices, std::vector<Vector3>& positions);
+
+    /// <summary>
+    /// Optimizes every primitive, distributing them over `threadCount` worker
+    /// threads. A `threadCount` of 0 uses the hardware concurrency.
+    /// </summary>
+    std::vector<OptimizeStats> optimizePrimitives(std::vector<Primitive>& primitives, unsigned int threadCount = 0);
+}
+
+#endif